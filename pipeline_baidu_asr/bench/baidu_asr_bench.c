@@ -0,0 +1,432 @@
+/* baidu_asr hot-path microbenchmark
+
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/*
+ * Drives _http_stream_writer_event_handle() from main/baidu_asr.c the way
+ * http_stream does for one utterance (PRE_REQUEST, one ON_REQUEST per I2S
+ * block, POST_REQUEST, FINISH_REQUEST), which covers chunk framing, base64
+ * encoding with the 3-byte carry, the BAIDU_ASR_BEGIN / BAIDU_ASR_END
+ * envelope and result parsing. Each buffer_size x block size combination
+ * reports ns per encoded PCM byte and heap allocations per utterance, and is
+ * compared against a stored baseline.
+ */
+
+#include <time.h>
+#include <unistd.h>
+
+/* Include the source itself so the static hot-path functions are reachable */
+#include "baidu_asr.c"
+
+#define BENCH_UTTERANCE_BYTES       (3 * 16000 * 2)     /* 3 s of 16 kHz, 16-bit mono PCM */
+#define BENCH_ITERATIONS            (10)                /* Utterances per timing sample */
+#define BENCH_SAMPLES               (31)                /* Best-of-N timing samples */
+#define BENCH_DEFAULT_TOLERANCE     (0.50)
+#define BENCH_MAX_RESULTS           (64)
+#define BENCH_CAPTURE_SIZE          (BENCH_UTTERANCE_BYTES * 2)
+
+static const int bench_buffer_sizes[] = { 1024, DEFAULT_SR_BUFFER_SIZE, 4096, 8192 };
+static const int bench_block_sizes[] = { 128, 256, 512, 1024, 2048, 4096 };
+
+typedef struct {
+    int         buffer_size;
+    int         block_size;
+    double      ns_per_byte;
+    long        allocs;
+    int         encoded_bytes;
+    baidu_asr_t *asr;
+} bench_result_t;
+
+static uint8_t bench_pcm[BENCH_UTTERANCE_BYTES];
+
+static void bench_fill_pcm(void)
+{
+    uint32_t seed = 0x12345678;
+    for (int i = 0; i < BENCH_UTTERANCE_BYTES; i++) {
+        seed = seed * 1103515245 + 12345;
+        bench_pcm[i] = seed >> 16;
+    }
+}
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/*
+ * The ON_REQUEST handler keeps up to 2 carry bytes in `buffer` and encodes
+ * into `b64_buffer`, both `buffer_size` long. Its own length guard is looser
+ * than that, so only sweep the combinations that actually fit.
+ */
+static bool bench_block_fits(int buffer_size, int block_size)
+{
+    int raw_len = block_size + 2;
+    return raw_len <= buffer_size && (raw_len + 2) / 3 * 4 + 1 <= buffer_size;
+}
+
+static esp_err_t bench_utterance(baidu_asr_t *asr, int block_size)
+{
+    http_stream_event_msg_t msg = {
+        .user_data = asr,
+    };
+
+    msg.event_id = HTTP_STREAM_PRE_REQUEST;
+    if (_http_stream_writer_event_handle(&msg) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    msg.event_id = HTTP_STREAM_ON_REQUEST;
+    for (int pos = 0; pos < BENCH_UTTERANCE_BYTES; pos += block_size) {
+        msg.buffer = bench_pcm + pos;
+        msg.buffer_len = BENCH_UTTERANCE_BYTES - pos;
+        if (msg.buffer_len > block_size) {
+            msg.buffer_len = block_size;
+        }
+        if (_http_stream_writer_event_handle(&msg) <= 0) {
+            return ESP_FAIL;
+        }
+    }
+
+    msg.buffer = NULL;
+    msg.buffer_len = 0;
+    msg.event_id = HTTP_STREAM_POST_REQUEST;
+    if (_http_stream_writer_event_handle(&msg) <= 0) {
+        return ESP_FAIL;
+    }
+
+    msg.event_id = HTTP_STREAM_FINISH_REQUEST;
+    if (_http_stream_writer_event_handle(&msg) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/*
+ * Run one utterance with the HTTP body captured, then de-chunk it and check
+ * the envelope and the base64 payload, so a change that makes the hot path
+ * faster by breaking it does not go unnoticed.
+ */
+static esp_err_t bench_validate(baidu_asr_t *asr, int block_size)
+{
+    static char wire[BENCH_CAPTURE_SIZE];
+    static char body[BENCH_CAPTURE_SIZE];
+    static unsigned char speech[BENCH_UTTERANCE_BYTES];
+    char envelope[256];
+    int wire_len, body_len = 0, pos = 0;
+
+    bench_http_capture(wire, sizeof(wire));
+    esp_err_t ret = bench_utterance(asr, block_size);
+    wire_len = bench_http_written();
+    bench_http_capture(NULL, 0);
+    if (ret != ESP_OK) {
+        fprintf(stderr, "%d/%d: Utterance failed\n", asr->buffer_size, block_size);
+        return ESP_FAIL;
+    }
+    if (wire_len < 0) {
+        fprintf(stderr, "%d/%d: Capture buffer too small\n", asr->buffer_size, block_size);
+        return ESP_FAIL;
+    }
+
+    while (1) {
+        char *end;
+        if (pos >= wire_len) {
+            fprintf(stderr, "%d/%d: Missing end chunk\n", asr->buffer_size, block_size);
+            return ESP_FAIL;
+        }
+        long chunk_len = strtol(wire + pos, &end, 16);
+        if (end == wire + pos || end + 2 > wire + wire_len || memcmp(end, "\r\n", 2) != 0) {
+            fprintf(stderr, "%d/%d: Bad chunk header at %d\n", asr->buffer_size, block_size, pos);
+            return ESP_FAIL;
+        }
+        pos = end - wire + 2;
+        if (chunk_len == 0) {
+            break;
+        }
+        if (pos + chunk_len + 2 > wire_len || memcmp(wire + pos + chunk_len, "\r\n", 2) != 0) {
+            fprintf(stderr, "%d/%d: Bad chunk trailer at %d\n", asr->buffer_size, block_size, pos);
+            return ESP_FAIL;
+        }
+        memcpy(body + body_len, wire + pos, chunk_len);
+        body_len += chunk_len;
+        pos += chunk_len + 2;
+    }
+    body[body_len] = 0;
+
+    int begin_len = snprintf(envelope, sizeof(envelope), BAIDU_ASR_BEGIN, asr->dev_pid, asr->record_sample_rates);
+    if (body_len < begin_len || memcmp(body, envelope, begin_len) != 0) {
+        fprintf(stderr, "%d/%d: Bad envelope begin\n", asr->buffer_size, block_size);
+        return ESP_FAIL;
+    }
+    char *b64 = body + begin_len;
+    char *b64_end = strchr(b64, '"');
+    size_t speech_len = 0;
+    if (b64_end == NULL
+        || mbedtls_base64_decode(speech, sizeof(speech), &speech_len, (unsigned char *)b64, b64_end - b64) != 0) {
+        fprintf(stderr, "%d/%d: Bad base64 payload\n", asr->buffer_size, block_size);
+        return ESP_FAIL;
+    }
+
+    /*
+     * Known defect: the first ON_REQUEST only sends BAIDU_ASR_BEGIN and drops
+     * its block, so every utterance loses its first I2S block of audio. Check
+     * the body against what the handler does today; once that is fixed,
+     * `skipped` becomes 0.
+     */
+    int skipped = block_size < BENCH_UTTERANCE_BYTES ? block_size : BENCH_UTTERANCE_BYTES;
+    if (speech_len != BENCH_UTTERANCE_BYTES - skipped
+        || memcmp(speech, bench_pcm + skipped, speech_len) != 0) {
+        fprintf(stderr, "%d/%d: Decoded speech does not match input\n", asr->buffer_size, block_size);
+        return ESP_FAIL;
+    }
+
+    snprintf(envelope, sizeof(envelope), BAIDU_ASR_END, (int)speech_len, asr->format, asr->cuid, asr->token, asr->channel);
+    if (strcmp(b64_end, envelope) != 0) {
+        fprintf(stderr, "%d/%d: Bad envelope end\n", asr->buffer_size, block_size);
+        return ESP_FAIL;
+    }
+    if (asr->response_text == NULL) {
+        fprintf(stderr, "%d/%d: No result parsed\n", asr->buffer_size, block_size);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/*
+ * Create the handle for one sweep point, check its output and count the
+ * allocations of one steady-state utterance. The handle is kept for timing.
+ */
+static esp_err_t bench_setup(bench_result_t *result)
+{
+    baidu_asr_config_t config = {
+        .access_key = "bench",
+        .secret_key = "bench",
+        .format = "pcm",
+        .record_sample_rates = 16000,
+        .channel = 1,
+        .cuid = "ESP32",
+        .dev_pid = 1536,
+        .buffer_size = result->buffer_size,
+    };
+    result->asr = baidu_asr_init(&config);
+    if (result->asr == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    /* First utterance also issues the access token, keep it out of the numbers */
+    if (bench_validate(result->asr, result->block_size) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    long allocs = bench_alloc_count;
+    if (bench_utterance(result->asr, result->block_size) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    result->allocs = bench_alloc_count - allocs;
+    result->encoded_bytes = result->asr->sr_total_raw;
+    if (result->encoded_bytes <= 0) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t bench_sample(bench_result_t *result)
+{
+    double start = bench_now_ns();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        if (bench_utterance(result->asr, result->block_size) != ESP_OK) {
+            return ESP_FAIL;
+        }
+    }
+    double ns_per_byte = (bench_now_ns() - start) / ((double)BENCH_ITERATIONS * result->encoded_bytes);
+    if (result->ns_per_byte == 0 || ns_per_byte < result->ns_per_byte) {
+        result->ns_per_byte = ns_per_byte;
+    }
+    return ESP_OK;
+}
+
+static int bench_load_baseline(const char *path, bench_result_t *baseline, int max)
+{
+    char line[128];
+    int count = 0;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Cannot open baseline %s\n", path);
+        return -1;
+    }
+    while (count < max && fgets(line, sizeof(line), f)) {
+        bench_result_t *b = &baseline[count];
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%d %d %lf %ld", &b->buffer_size, &b->block_size, &b->ns_per_byte, &b->allocs) != 4) {
+            fprintf(stderr, "Bad baseline line: %s", line);
+            fclose(f);
+            return -1;
+        }
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+static int bench_save_baseline(const char *path, const bench_result_t *results, int count)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Cannot write baseline %s\n", path);
+        return -1;
+    }
+    fprintf(f, "# baidu_asr hot-path baseline, regenerate with `make -C bench baseline`\n");
+    fprintf(f, "# buffer_size block_size ns_per_byte allocs_per_utterance\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(f, "%d %d %.3f %ld\n", results[i].buffer_size, results[i].block_size,
+                results[i].ns_per_byte, results[i].allocs);
+    }
+    fclose(f);
+    return 0;
+}
+
+static void bench_usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [-b baseline] [-w baseline] [-t tolerance]\n", name);
+    fprintf(stderr, "  -b  compare against this baseline and fail on regression\n");
+    fprintf(stderr, "  -w  write the results as the new baseline\n");
+    fprintf(stderr, "  -t  allowed ns/byte slowdown, default %.2f (= +%d%%)\n",
+            BENCH_DEFAULT_TOLERANCE, (int)(BENCH_DEFAULT_TOLERANCE * 100));
+}
+
+int main(int argc, char *argv[])
+{
+    static bench_result_t results[BENCH_MAX_RESULTS];
+    static bench_result_t baseline[BENCH_MAX_RESULTS];
+    static bool baseline_matched[BENCH_MAX_RESULTS];
+    const char *baseline_in = NULL;
+    const char *baseline_out = NULL;
+    double tolerance = BENCH_DEFAULT_TOLERANCE;
+    int baseline_count = 0, result_count = 0, regressions = 0, failures = 0;
+    int opt;
+    char *end;
+
+    while ((opt = getopt(argc, argv, "b:w:t:")) != -1) {
+        switch (opt) {
+            case 'b':
+                baseline_in = optarg;
+                break;
+            case 'w':
+                baseline_out = optarg;
+                break;
+            case 't':
+                tolerance = strtod(optarg, &end);
+                if (end == optarg || *end != 0 || tolerance < 0) {
+                    fprintf(stderr, "Invalid tolerance: %s\n", optarg);
+                    return 2;
+                }
+                break;
+            default:
+                bench_usage(argv[0]);
+                return 2;
+        }
+    }
+
+    if (baseline_in) {
+        baseline_count = bench_load_baseline(baseline_in, baseline, BENCH_MAX_RESULTS);
+        if (baseline_count < 0) {
+            return 2;
+        }
+    }
+
+    bench_fill_pcm();
+    for (int i = 0; i < sizeof(bench_buffer_sizes) / sizeof(bench_buffer_sizes[0]); i++) {
+        for (int j = 0; j < sizeof(bench_block_sizes) / sizeof(bench_block_sizes[0]); j++) {
+            bench_result_t *r = &results[result_count];
+            r->buffer_size = bench_buffer_sizes[i];
+            r->block_size = bench_block_sizes[j];
+            if (!bench_block_fits(r->buffer_size, r->block_size)) {
+                continue;
+            }
+            esp_err_t ret = bench_setup(r);
+            if (ret == ESP_ERR_NO_MEM) {
+                printf("%d/%d: FAIL (baidu_asr_init)\n", r->buffer_size, r->block_size);
+                failures++;
+            } else if (ret != ESP_OK) {
+                printf("%d/%d: FAIL (bad output)\n", r->buffer_size, r->block_size);
+                failures++;
+            }
+            result_count++;
+        }
+    }
+    if (failures) {
+        printf("%d combination(s) failed before timing\n", failures);
+        return 1;
+    }
+
+    /* Round-robin the samples over the whole sweep, so a slow phase of the
+     * host only costs a few samples of each point instead of a whole point */
+    for (int s = 0; s < BENCH_SAMPLES; s++) {
+        for (int i = 0; i < result_count; i++) {
+            if (bench_sample(&results[i]) != ESP_OK) {
+                printf("%d/%d: FAIL (utterance)\n", results[i].buffer_size, results[i].block_size);
+                return 1;
+            }
+        }
+    }
+
+    printf("Utterance: %d bytes PCM, best of %d x %d utterances\n",
+           BENCH_UTTERANCE_BYTES, BENCH_SAMPLES, BENCH_ITERATIONS);
+    printf("%11s %6s %9s %10s %9s  %s\n", "buffer_size", "block", "ns/byte", "allocs/utt", "baseline", "status");
+    for (int i = 0; i < result_count; i++) {
+        const bench_result_t *r = &results[i];
+        const bench_result_t *b = NULL;
+        baidu_asr_destroy(r->asr);
+        for (int k = 0; k < baseline_count; k++) {
+            if (baseline[k].buffer_size == r->buffer_size && baseline[k].block_size == r->block_size) {
+                b = &baseline[k];
+                baseline_matched[k] = true;
+                break;
+            }
+        }
+        if (b == NULL) {
+            printf("%11d %6d %9.3f %10ld %9s  %s\n", r->buffer_size, r->block_size, r->ns_per_byte, r->allocs,
+                   "-", baseline_in ? "FAIL (not in baseline)" : "");
+            if (baseline_in) {
+                regressions++;
+            }
+            continue;
+        }
+
+        const char *status = "ok";
+        if (r->allocs > b->allocs) {
+            status = "FAIL (allocations)";
+            regressions++;
+        } else if (r->ns_per_byte > b->ns_per_byte * (1 + tolerance)) {
+            status = "FAIL (slower)";
+            regressions++;
+        }
+        printf("%11d %6d %9.3f %10ld %9.3f  %s\n", r->buffer_size, r->block_size, r->ns_per_byte, r->allocs,
+               b->ns_per_byte, status);
+    }
+    /* A sweep point that disappeared must not pass silently either */
+    for (int k = 0; k < baseline_count; k++) {
+        if (!baseline_matched[k]) {
+            printf("%11d %6d %9s %10s %9.3f  FAIL (not in sweep)\n", baseline[k].buffer_size, baseline[k].block_size,
+                   "-", "-", baseline[k].ns_per_byte);
+            regressions++;
+        }
+    }
+
+    if (baseline_out && bench_save_baseline(baseline_out, results, result_count) != 0) {
+        return 2;
+    }
+    if (regressions) {
+        printf("%d regression(s) against %s (tolerance +%.0f%%)\n", regressions, baseline_in, tolerance * 100);
+        return 1;
+    }
+    return 0;
+}
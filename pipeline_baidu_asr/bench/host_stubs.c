@@ -0,0 +1,213 @@
+/* Host stand-ins for the ESP-IDF / ESP-ADF APIs used by baidu_asr.c
+
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#include <stdarg.h>
+#include <string.h>
+#include "host_stubs.h"
+
+#define BENCH_ACCESS_TOKEN  "24.0123456789abcdef0123456789abcdef.2592000.1541234567.282335-12345678"
+#define BENCH_ASR_RESPONSE  "{\"corpus_no\":\"6622346254497452385\",\"err_msg\":\"success.\",\"err_no\":0," \
+                            "\"result\":[\"\xe7\x99\xbe\xe5\xba\xa6\xe8\xaf\xad\xe9\x9f\xb3\"],"           \
+                            "\"sn\":\"717440569891540800316\"}"
+
+/*
+ * Allocation counting. glibc routes every heap allocation (including the
+ * ones made inside strdup) through these symbols, so interposing them here
+ * counts allocations made by baidu_asr.c and json_utils.c alike.
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+volatile long bench_alloc_count;
+
+void *malloc(size_t size)
+{
+    bench_alloc_count++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    bench_alloc_count++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    bench_alloc_count++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+void bench_log(const char *tag, const char *fmt, ...)
+{
+    static char log_buffer[512];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(log_buffer, sizeof(log_buffer), fmt, args);
+    va_end(args);
+}
+
+/* esp_http_client */
+static char *capture_buffer;
+static int capture_size;
+static int capture_len;
+
+void bench_http_capture(char *buf, int size)
+{
+    capture_buffer = buf;
+    capture_size = size;
+    capture_len = 0;
+}
+
+int bench_http_written(void)
+{
+    return capture_len;
+}
+
+int esp_http_client_write(esp_http_client_handle_t client, const char *buffer, int len)
+{
+    if (capture_len < 0) {
+        return len;
+    }
+    if (capture_buffer) {
+        if (capture_len + len > capture_size) {
+            capture_len = -1;
+            return len;
+        }
+        memcpy(capture_buffer + capture_len, buffer, len);
+    }
+    capture_len += len;
+    return len;
+}
+
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len)
+{
+    int read_len = sizeof(BENCH_ASR_RESPONSE) - 1;
+    if (read_len > len) {
+        read_len = len;
+    }
+    memcpy(buffer, BENCH_ASR_RESPONSE, read_len);
+    return read_len;
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+    return ESP_OK;
+}
+
+/* audio_element / audio_pipeline */
+static char dummy_handle;
+
+audio_pipeline_handle_t audio_pipeline_init(audio_pipeline_cfg_t *config)
+{
+    return (audio_pipeline_handle_t)&dummy_handle;
+}
+
+esp_err_t audio_pipeline_deinit(audio_pipeline_handle_t pipeline)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_register(audio_pipeline_handle_t pipeline, audio_element_handle_t el, const char *name)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_link(audio_pipeline_handle_t pipeline, const char *link_tag[], int link_num)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_run(audio_pipeline_handle_t pipeline)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_stop(audio_pipeline_handle_t pipeline)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_wait_for_stop(audio_pipeline_handle_t pipeline)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_terminate(audio_pipeline_handle_t pipeline)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_set_listener(audio_pipeline_handle_t pipeline, audio_event_iface_handle_t evt)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_remove_listener(audio_pipeline_handle_t pipeline)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_reset_items_state(audio_pipeline_handle_t pipeline)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_pipeline_reset_ringbuffer(audio_pipeline_handle_t pipeline)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_element_deinit(audio_element_handle_t el)
+{
+    return ESP_OK;
+}
+
+esp_err_t audio_element_set_uri(audio_element_handle_t el, const char *uri)
+{
+    return ESP_OK;
+}
+
+audio_element_handle_t http_stream_init(http_stream_cfg_t *config)
+{
+    return (audio_element_handle_t)&dummy_handle;
+}
+
+audio_element_handle_t i2s_stream_init(i2s_stream_cfg_t *config)
+{
+    return (audio_element_handle_t)&dummy_handle;
+}
+
+esp_err_t i2s_stream_set_clk(audio_element_handle_t i2s_stream, int rate, int bits, int ch)
+{
+    return ESP_OK;
+}
+
+/* adf_utils: the token request is a network round trip, not part of the hot path */
+char *baidu_get_access_token(const char *access_key, const char *access_secret)
+{
+    return strdup(BENCH_ACCESS_TOKEN);
+}
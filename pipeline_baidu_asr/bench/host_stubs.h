@@ -0,0 +1,169 @@
+/* Host stand-ins for the ESP-IDF / ESP-ADF APIs used by baidu_asr.c
+
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/*
+ * Every device header included by baidu_asr.c (esp_log.h, http_stream.h, ...)
+ * is generated by bench/Makefile as a one-line wrapper around this file, so
+ * main/baidu_asr.c compiles on Linux unmodified. Only what the hot path
+ * touches is modelled; the pipeline, I2S and event calls are no-ops.
+ */
+
+#ifndef _HOST_STUBS_H_
+#define _HOST_STUBS_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int esp_err_t;
+
+#define ESP_OK          (0)
+#define ESP_FAIL        (-1)
+#define ESP_ERR_NO_MEM  (0x101)
+
+/* Logging: format into a scratch buffer so the cost of the per-chunk log
+ * lines stays in the measurement, but nothing goes out to the console. */
+void bench_log(const char *tag, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+#define ESP_LOGE(tag, fmt, ...) bench_log(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) bench_log(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) bench_log(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) bench_log(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) bench_log(tag, fmt, ##__VA_ARGS__)
+
+#define AUDIO_MEM_CHECK(tag, a, action) if (!(a)) {                 \
+        ESP_LOGE(tag, "%s:%d (%s): %s", __FILE__, __LINE__, __FUNCTION__, "Memory exhausted"); \
+        action;                                                     \
+    }
+
+/* esp_http_client */
+typedef struct esp_http_client *esp_http_client_handle_t;
+
+typedef enum {
+    HTTP_METHOD_GET = 0,
+    HTTP_METHOD_POST,
+} esp_http_client_method_t;
+
+int esp_http_client_write(esp_http_client_handle_t client, const char *buffer, int len);
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len);
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method);
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len);
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value);
+
+/* audio_element / audio_pipeline / audio_event_iface */
+typedef struct audio_element *audio_element_handle_t;
+typedef struct audio_pipeline *audio_pipeline_handle_t;
+typedef struct audio_event_iface *audio_event_iface_handle_t;
+
+typedef enum {
+    AUDIO_STREAM_NONE = 0,
+    AUDIO_STREAM_READER,
+    AUDIO_STREAM_WRITER,
+} audio_stream_type_t;
+
+typedef struct {
+    int rb_size;
+} audio_pipeline_cfg_t;
+
+#define DEFAULT_AUDIO_PIPELINE_CONFIG() {   \
+    .rb_size = 8 * 1024,                    \
+}
+
+audio_pipeline_handle_t audio_pipeline_init(audio_pipeline_cfg_t *config);
+esp_err_t audio_pipeline_deinit(audio_pipeline_handle_t pipeline);
+esp_err_t audio_pipeline_register(audio_pipeline_handle_t pipeline, audio_element_handle_t el, const char *name);
+esp_err_t audio_pipeline_link(audio_pipeline_handle_t pipeline, const char *link_tag[], int link_num);
+esp_err_t audio_pipeline_run(audio_pipeline_handle_t pipeline);
+esp_err_t audio_pipeline_stop(audio_pipeline_handle_t pipeline);
+esp_err_t audio_pipeline_wait_for_stop(audio_pipeline_handle_t pipeline);
+esp_err_t audio_pipeline_terminate(audio_pipeline_handle_t pipeline);
+esp_err_t audio_pipeline_set_listener(audio_pipeline_handle_t pipeline, audio_event_iface_handle_t evt);
+esp_err_t audio_pipeline_remove_listener(audio_pipeline_handle_t pipeline);
+esp_err_t audio_pipeline_reset_items_state(audio_pipeline_handle_t pipeline);
+esp_err_t audio_pipeline_reset_ringbuffer(audio_pipeline_handle_t pipeline);
+esp_err_t audio_element_deinit(audio_element_handle_t el);
+esp_err_t audio_element_set_uri(audio_element_handle_t el, const char *uri);
+
+/* http_stream */
+typedef enum {
+    HTTP_STREAM_PRE_REQUEST = 0x01,
+    HTTP_STREAM_ON_REQUEST,
+    HTTP_STREAM_ON_RESPONSE,
+    HTTP_STREAM_POST_REQUEST,
+    HTTP_STREAM_FINISH_REQUEST,
+} http_stream_event_id_t;
+
+typedef struct {
+    http_stream_event_id_t  event_id;
+    void                    *http_client;
+    void                    *buffer;
+    int                     buffer_len;
+    void                    *user_data;
+    audio_element_handle_t  el;
+} http_stream_event_msg_t;
+
+typedef int (*http_stream_event_handle_t)(http_stream_event_msg_t *msg);
+
+typedef struct {
+    audio_stream_type_t         type;
+    int                         out_rb_size;
+    int                         task_stack;
+    http_stream_event_handle_t  event_handle;
+    void                        *user_data;
+} http_stream_cfg_t;
+
+audio_element_handle_t http_stream_init(http_stream_cfg_t *config);
+
+/* i2s_stream */
+typedef struct {
+    audio_stream_type_t type;
+    int                 out_rb_size;
+} i2s_stream_cfg_t;
+
+#define I2S_STREAM_CFG_DEFAULT() {  \
+    .type = AUDIO_STREAM_NONE,      \
+    .out_rb_size = 8 * 1024,        \
+}
+
+audio_element_handle_t i2s_stream_init(i2s_stream_cfg_t *config);
+esp_err_t i2s_stream_set_clk(audio_element_handle_t i2s_stream, int rate, int bits, int ch);
+
+/* adf_utils */
+char *baidu_get_access_token(const char *access_key, const char *access_secret);
+char *json_get_token_value(const char *buffer, const char *key);
+
+/* Bench hooks */
+extern volatile long bench_alloc_count;
+
+/**
+ * @brief      Capture everything written through esp_http_client_write into `buf`
+ *
+ * @param      buf   Capture buffer, NULL to only count bytes
+ * @param[in]  size  Capture buffer size
+ */
+void bench_http_capture(char *buf, int size);
+
+/**
+ * @brief      Get the number of bytes written since the last bench_http_capture() call
+ *
+ * @return     Bytes written, or -1 if the capture buffer overflowed
+ */
+int bench_http_written(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif